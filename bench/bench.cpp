@@ -0,0 +1,293 @@
+/**
+ * @file bench.cpp
+ * @brief Host micro-benchmarks for the firmware hot paths in ../main.cpp.
+ *
+ * main.cpp is compiled unchanged against the Arduino shims in shim/. Each benchmark reports the
+ * median ns/op over 15 runs and the number of heap allocations made while it ran (the firmware must not
+ * allocate). With --baseline, results slower than the stored baseline by more than the tolerance
+ * are flagged and the exit code is non-zero. The weighing benchmarks also check the adaptive
+ * sampler's behaviour (sample count and grading) and fail with EXPECTATION if it changes.
+ *
+ * Host ns/op is a relative guard for firmware changes, not an AVR cycle count.
+ */
+#include "../main.cpp"
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+// ==================== ALLOCATION COUNTING ====================
+static unsigned long allocationCount = 0;
+
+void *operator new(size_t size) {
+#if !defined(__GLIBC__)
+    allocationCount++; // With glibc the malloc() override below counts it
+#endif
+    void *p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return p;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+#if defined(__GLIBC__)
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *malloc(size_t size) {
+    allocationCount++;
+    return __libc_malloc(size);
+}
+#endif
+
+// ==================== HARNESS ====================
+struct BenchResult {
+    std::string name;
+    double nsPerOp;
+    unsigned long allocations;
+    bool expectationMet;
+};
+
+static volatile long benchSink = 0;
+
+template <class Fn>
+static BenchResult runBench(const char *name, Fn fn) {
+    typedef std::chrono::steady_clock Clock;
+    const double MIN_RUN_NS = 20e6;
+    const int RUNS = 15;
+
+    // Size one run to at least MIN_RUN_NS
+    unsigned long iterations = 1;
+    for (;;) {
+        Clock::time_point start = Clock::now();
+        for (unsigned long i = 0; i < iterations; i++) fn(i);
+        double elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        if (elapsed >= MIN_RUN_NS || iterations >= (1UL << 30)) break;
+        iterations *= 2;
+    }
+
+    // Median of RUNS: robust to both scheduler hiccups and the odd unusually fast run
+    double perRun[RUNS];
+    unsigned long allocationsBefore = allocationCount;
+    for (int run = 0; run < RUNS; run++) {
+        Clock::time_point start = Clock::now();
+        for (unsigned long i = 0; i < iterations; i++) fn(i);
+        perRun[run] = std::chrono::duration<double, std::nano>(Clock::now() - start).count() / iterations;
+    }
+
+    unsigned long allocations = allocationCount - allocationsBefore;
+    std::sort(perRun, perRun + RUNS);
+
+    BenchResult result;
+    result.name = name;
+    result.nsPerOp = perRun[RUNS / 2];
+    result.allocations = allocations;
+    result.expectationMet = true;
+    return result;
+}
+
+// Deterministic load cell noise, uniform in [-0.15, 0.15] g
+static uint32_t noiseState = 12345;
+static float loadCellNoise() {
+    noiseState = noiseState * 1664525u + 1013904223u;
+    return ((noiseState >> 8) / 16777216.0f - 0.5f) * 0.3f;
+}
+
+// Weighs one egg with the adaptive sampler and returns the sample count used
+static byte weighOnce(float trueWeight) {
+    resetWeighSamples();
+    do {
+        addWeighSample(trueWeight + loadCellNoise());
+    } while (!weighEstimateIsSettled());
+    return weighSampleCount;
+}
+
+/**
+ * @brief Checks the adaptive sampler over many noisy weighings of one egg: the estimate must always
+ * land in the same bin as the true weight, and the average sample count must be within range.
+ */
+static bool weighExpectationMet(float trueWeight, float minAvgSamples, float maxAvgSamples) {
+    const int TRIALS = 1000;
+    unsigned long totalSamples = 0;
+    bool graded = true;
+
+    currentEggWeight = trueWeight;
+    int trueBin = classifyEgg();
+    for (int i = 0; i < TRIALS; i++) {
+        totalSamples += weighOnce(trueWeight);
+        currentEggWeight = weighMean;
+        if (classifyEgg() != trueBin) graded = false;
+    }
+
+    float avgSamples = (float)totalSamples / TRIALS;
+    return graded && avgSamples >= minAvgSamples && avgSamples <= maxAvgSamples;
+}
+
+static std::vector<BenchResult> runAll() {
+    std::vector<BenchResult> results;
+
+    // Covers every classifyEgg() branch with the default ranges
+    static const float weights[16] = {
+        -3.0f, 20.0f, 34.9f, 35.0f, 38.5f, 42.0f, 42.5f, 43.0f,
+        46.0f, 50.0f, 50.5f, 51.0f, 55.0f, 58.0f, 63.0f, 47.0f
+    };
+    results.push_back(runBench("classify_egg", [](unsigned long i) {
+        currentEggWeight = weights[i & 15];
+        benchSink += classifyEgg();
+    }));
+
+    results.push_back(runBench("cmd_set_ranges", [](unsigned long) {
+        Serial.feed("SET_RANGES 35 42 43 50 51 58\n");
+        handleSerialCommands();
+    }));
+
+    results.push_back(runBench("cmd_weigh_mode", [](unsigned long) {
+        Serial.feed("WEIGH_MODE STRICT\n");
+        handleSerialCommands();
+    }));
+
+    results.push_back(runBench("cmd_quality", [](unsigned long) {
+        currentSortingStep = STEP_WAIT_FOR_QUALITY;
+        Serial.feed("QUALITY GOOD\n");
+        handleSerialCommands();
+        benchSink += currentSortingStep;
+    }));
+
+    results.push_back(runBench("cmd_unknown", [](unsigned long) {
+        Serial.feed("NOT_A_COMMAND 1 2 3\n");
+        handleSerialCommands();
+    }));
+
+    results.push_back(runBench("weigh_math_far", [](unsigned long) {
+        benchSink += weighOnce(46.5f); // 3.5 g from the nearest boundary
+    }));
+    // Far from every boundary: the fast estimate alone must decide
+    results.back().expectationMet = weighExpectationMet(46.5f, WEIGH_FAST_SAMPLES, WEIGH_FAST_SAMPLES);
+
+    results.push_back(runBench("weigh_math_boundary", [](unsigned long) {
+        benchSink += weighOnce(42.9f); // 0.1 g below mediumMin
+    }));
+    // Ambiguous: must keep sampling (nearly always to WEIGH_MAX_SAMPLES) and never misgrade
+    results.back().expectationMet = weighExpectationMet(42.9f, WEIGH_MAX_SAMPLES - 0.1f, WEIGH_MAX_SAMPLES);
+
+    // Full STEP_WEIGH_READ pass: sampling, empty-slot check, classification, SORT_READY
+    hostHx711Noise = loadCellNoise;
+    hostHx711Weight = 46.5f;
+    hx711_calibrated = true;
+    plainMode = false;
+    results.push_back(runBench("weigh_read_step", [](unsigned long) {
+        currentSortingStep = STEP_WEIGH_READ;
+        stepStartTime = millis();
+        resetWeighSamples();
+        while (currentSortingStep == STEP_WEIGH_READ) runContinuousSorting();
+        benchSink += weightClassificationIndex;
+    }));
+    hostHx711Noise = nullptr;
+    currentSortingStep = STEP_IDLE;
+
+    return results;
+}
+
+// ==================== BASELINE ====================
+static bool readBaseline(const char *path, std::vector<BenchResult> &baseline) {
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    char line[128];
+    while (fgets(line, sizeof(line), f)) {
+        char name[64];
+        double ns;
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%63s %lf", name, &ns) == 2) {
+            BenchResult entry;
+            entry.name = name;
+            entry.nsPerOp = ns;
+            entry.allocations = 0;
+            entry.expectationMet = true;
+            baseline.push_back(entry);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static bool writeBaseline(const char *path, const std::vector<BenchResult> &results) {
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "# MEGG firmware host benchmark baseline (ns/op). Regenerate with: make -C bench baseline\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        fprintf(f, "%-24s %10.1f\n", results[i].name.c_str(), results[i].nsPerOp);
+    }
+    fclose(f);
+    return true;
+}
+
+static void usage() {
+    fprintf(stderr, "Usage: megg_bench [--baseline <file> [--tolerance <fraction>]] [--write-baseline <file>]\n");
+}
+
+int main(int argc, char **argv) {
+    const char *baselinePath = nullptr;
+    const char *writePath = nullptr;
+    double tolerance = 0.50;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) baselinePath = argv[++i];
+        else if (strcmp(argv[i], "--write-baseline") == 0 && i + 1 < argc) writePath = argv[++i];
+        else if (strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) tolerance = atof(argv[++i]);
+        else {
+            usage();
+            return 2;
+        }
+    }
+
+    std::vector<BenchResult> baseline;
+    if (baselinePath && !readBaseline(baselinePath, baseline)) {
+        fprintf(stderr, "ERROR: Cannot read baseline %s\n", baselinePath);
+        return 2;
+    }
+
+    std::vector<BenchResult> results = runAll();
+
+    bool failed = false;
+    printf("%-24s %10s %10s %8s %7s  %s\n", "benchmark", "ns/op", "baseline", "delta", "allocs", "status");
+    for (size_t i = 0; i < results.size(); i++) {
+        const BenchResult &r = results[i];
+        const char *status = "ok";
+        char baseText[16] = "-";
+        char deltaText[16] = "-";
+
+        for (size_t j = 0; j < baseline.size(); j++) {
+            if (baseline[j].name != r.name) continue;
+            double delta = (r.nsPerOp - baseline[j].nsPerOp) / baseline[j].nsPerOp;
+            snprintf(baseText, sizeof(baseText), "%.1f", baseline[j].nsPerOp);
+            snprintf(deltaText, sizeof(deltaText), "%+.0f%%", delta * 100.0);
+            if (delta > tolerance) {
+                status = "REGRESSION";
+                failed = true;
+            }
+        }
+        if (r.allocations != 0) {
+            status = "ALLOCATES";
+            failed = true;
+        }
+        if (!r.expectationMet) {
+            status = "EXPECTATION";
+            failed = true;
+        }
+
+        printf("%-24s %10.1f %10s %8s %7lu  %s\n", r.name.c_str(), r.nsPerOp, baseText, deltaText, r.allocations, status);
+    }
+
+    if (writePath) {
+        if (!writeBaseline(writePath, results)) {
+            fprintf(stderr, "ERROR: Cannot write baseline %s\n", writePath);
+            return 2;
+        }
+        printf("Baseline written to %s\n", writePath);
+    }
+
+    return failed ? 1 : 0;
+}
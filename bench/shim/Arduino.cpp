@@ -0,0 +1,29 @@
+#include <Arduino.h>
+#include <HX711.h>
+#include <EEPROM.h>
+#include <chrono>
+
+HostSerial Serial;
+HostEEPROM EEPROM;
+float hostHx711Weight = 0.0f;
+float (*hostHx711Noise)() = nullptr;
+
+static uint8_t pinLevels[32];
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+unsigned long millis() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros() {
+    return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(unsigned long) {}
+void delayMicroseconds(unsigned int) {}
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t pin, uint8_t val) { pinLevels[pin & 31] = val; }
+int digitalRead(uint8_t pin) { return pinLevels[pin & 31]; }
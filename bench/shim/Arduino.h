@@ -0,0 +1,94 @@
+// Host shim of the Arduino core: just enough of the API for main.cpp to build and run on a PC.
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+#define DEC 10
+#define HEX 16
+
+static const uint8_t A0 = 14;
+static const uint8_t A1 = 15;
+
+// No PROGMEM on the host: F() strings are plain C strings behind the usual marker type
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+/**
+ * @brief Serial stand-in. Output is formatted (so its cost is measured) and counted, not printed
+ * unless echo is set.
+ * Input is fed from a string with feed().
+ */
+class HostSerial {
+public:
+    void begin(unsigned long) {}
+
+    int available() { return (int)(inputLength - inputPos); }
+    int read() { return inputPos < inputLength ? (unsigned char)input[inputPos++] : -1; }
+    void feed(const char *data) {
+        input = data;
+        inputLength = strlen(data);
+        inputPos = 0;
+    }
+
+    size_t print(const __FlashStringHelper *s) { return print(reinterpret_cast<const char *>(s)); }
+    size_t print(const char *s) { return write(s, strlen(s)); }
+    size_t print(char c) { return write(&c, 1); }
+    size_t print(int n, int base = DEC) { return printNumber((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return printNumber((unsigned long)n, base); }
+    size_t print(long n, int base = DEC) { return printNumber(n, base); }
+    size_t print(unsigned long n, int base = DEC) { return printNumber(n, base); }
+    size_t print(unsigned char n, int base = DEC) { return printNumber((unsigned long)n, base); }
+    size_t print(double n, int digits = 2) {
+        char buf[32];
+        return write(buf, snprintf(buf, sizeof(buf), "%.*f", digits, n));
+    }
+
+    template <class T> size_t println(T value) { size_t n = print(value); return n + println(); }
+    template <class T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+    size_t println() { return write("\r\n", 2); }
+
+    unsigned long bytesWritten = 0;
+    FILE *echo = nullptr; // Set to a stream (e.g. stdout) to see the output while debugging
+
+private:
+    size_t write(const char *s, size_t n) {
+        bytesWritten += n;
+        if (echo) fwrite(s, 1, n, echo);
+        return n;
+    }
+    size_t printNumber(long n, int base) {
+        char buf[24];
+        return write(buf, snprintf(buf, sizeof(buf), base == HEX ? "%lX" : "%ld", n));
+    }
+    size_t printNumber(unsigned long n, int base) {
+        char buf[24];
+        return write(buf, snprintf(buf, sizeof(buf), base == HEX ? "%lX" : "%lu", n));
+    }
+
+    const char *input = "";
+    size_t inputLength = 0;
+    size_t inputPos = 0;
+};
+
+extern HostSerial Serial;
@@ -0,0 +1,15 @@
+// Host shim of the AVR EEPROM library (1 KB, erased to 0xFF like a new ATmega328P).
+#pragma once
+#include <Arduino.h>
+
+class HostEEPROM {
+public:
+    HostEEPROM() { memset(bytes, 0xFF, sizeof(bytes)); }
+    template <class T> T &get(int idx, T &t) { memcpy(&t, bytes + idx, sizeof(T)); return t; }
+    template <class T> const T &put(int idx, const T &t) { memcpy(bytes + idx, &t, sizeof(T)); return t; }
+
+private:
+    uint8_t bytes[1024];
+};
+
+extern HostEEPROM EEPROM;
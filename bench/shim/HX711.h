@@ -0,0 +1,29 @@
+// Host shim of the bogde/HX711 library. Returns hostHx711Weight (g) plus optional hostHx711Noise.
+#pragma once
+#include <Arduino.h>
+
+extern float hostHx711Weight;
+extern float (*hostHx711Noise)();
+
+class HX711 {
+public:
+    void begin(uint8_t dout, uint8_t pd_sck, uint8_t gain = 128) { (void)dout; (void)pd_sck; (void)gain; }
+    bool is_ready() { return true; }
+    long read() { return offset + (long)(get_units(1) * scale); }
+    long read_average(uint8_t times = 10) { (void)times; return read(); }
+    double get_value(uint8_t times = 1) { return read_average(times) - offset; }
+    float get_units(uint8_t times = 1) {
+        float sum = 0.0f;
+        for (uint8_t i = 0; i < times; i++) sum += hostHx711Weight + (hostHx711Noise ? hostHx711Noise() : 0.0f);
+        return sum / (times ? times : 1);
+    }
+    void tare(uint8_t times = 10) { (void)times; }
+    void set_scale(float s = 1.f) { scale = s; }
+    float get_scale() { return scale; }
+    void set_offset(long o = 0) { offset = o; }
+    long get_offset() { return offset; }
+
+private:
+    float scale = 1.0f;
+    long offset = 0;
+};
@@ -0,0 +1,14 @@
+// Host shim of the Arduino Servo library.
+#pragma once
+#include <Arduino.h>
+
+class Servo {
+public:
+    uint8_t attach(int pin) { attachedPin = pin; return 1; }
+    void write(int value) { angle = value; }
+    int read() { return angle; }
+
+private:
+    int attachedPin = -1;
+    int angle = 90;
+};
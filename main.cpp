@@ -4,8 +4,11 @@
 #include <EEPROM.h>
 
 // ==================== DEVELOPMENT FLAGS ====================
-// Set to true to allow 'START' command even if HX711 is not calibrated (for demonstration/testing)
-#define ALLOW_UNCALIBRATED_START true
+// DEV ONLY - keep false for production builds.
+// Set to true to boot in WEIGH_DEMO mode: 'START' is allowed even if HX711 is not calibrated and
+// test weights are injected when the scale is not ready (for demonstration/testing).
+// With false (default) the firmware boots in WEIGH_STRICT; DEMO is then only reachable via 'WEIGH_MODE DEMO'.
+#define ALLOW_UNCALIBRATED_START false
 
 // ==================== FUNCTION DECLARATIONS ====================
 void handleSerialCommands();
@@ -15,20 +18,120 @@ void homeServo();
 void runContinuousSorting();
 void sendStatus();
 int classifyEgg(); // Returns index (0=BAD, 1=SMALL, 2=MEDIUM, 3=LARGE)
+bool smallMinClearsEmptyThreshold(float s_min);
+void resetWeighSamples();
+void addWeighSample(float sample);
+float nearestGradeBoundaryDistance(float weight);
+bool weighEstimateIsSettled();
+void printEvent(const __FlashStringHelper *message, bool perEgg = true);
+void endEvent(bool perEgg = true);
 void calibrateUno();
 void calibrateHX711(float known_weight = 23.0f);
 void calibrateNema23();
 void calibrateLoaderServo();
 void calibrateMG996R();
 
-// ==================== PIN DEFINITIONS ====================
-#define LOADER_SERVO_PIN 6
-#define MG996R_PIN 5
-#define HX711_DT_PIN A0
-#define HX711_SCK_PIN A1
-#define NEMA23_STEP_PIN 3
-#define NEMA23_DIR_PIN 4
-#define NEMA23_ENABLE_PIN 2
+// ==================== MACHINE PROFILES ====================
+// Every hardware variant is a struct of compile-time constants (pins, servo angles, stepper timing, bin angles).
+// MeggUnoProfile below is the default. To build another variant, put its profile struct in a header
+// (same members as MeggUnoProfile) and build with:
+//   -DMEGG_PROFILE_HEADER='"my_variant_profile.h"' -DMEGG_PROFILE=MyVariantProfile
+// The firmware below only reads Machine::*.
+struct MeggUnoProfile {
+    // Pins
+    static constexpr uint8_t LOADER_SERVO_PIN = 6;
+    static constexpr uint8_t MG996R_PIN = 5;
+    static constexpr uint8_t HX711_DT_PIN = A0;
+    static constexpr uint8_t HX711_SCK_PIN = A1;
+    static constexpr uint8_t NEMA23_STEP_PIN = 3;
+    static constexpr uint8_t NEMA23_DIR_PIN = 4;
+    static constexpr uint8_t NEMA23_ENABLE_PIN = 2;
+
+    // Servo positions
+    static constexpr int LOADER_HOME_POS = 160; // Loader MG996R Home position (Egg Holder Up/Safe)
+    static constexpr int LOADER_LOAD_POS = 100; // Loader MG996R Load position (Egg Holder Down/Release)
+    static constexpr int MG996R_HOME_POS = 90;  // MG996R Neutral/Home position (Only used on HOME/STOP)
+
+    // Sorting bins (MG996R angle per classification index; the bin count is fixed, see BIN_COUNT)
+    static constexpr int BIN_POS_BAD = 15;
+    static constexpr int BIN_POS_SMALL = 70;
+    static constexpr int BIN_POS_MEDIUM = 125;
+    static constexpr int BIN_POS_LARGE = 170;
+
+    // Stepper
+    static constexpr int NEMA23_STEPS = 1600; // Steps for one index movement
+    static constexpr unsigned long STEP_PULSE_DELAY_US = 800; // Time for HIGH or LOW state of the pulse (800us HIGH + 800us LOW)
+};
+
+#ifdef MEGG_PROFILE_HEADER
+#include MEGG_PROFILE_HEADER
+#endif
+
+#ifndef MEGG_PROFILE
+#define MEGG_PROFILE MeggUnoProfile
+#endif
+typedef MEGG_PROFILE Machine;
+
+// Not a profile setting: classifyEgg() returns indices 0-3 (BAD, SMALL, MEDIUM, LARGE)
+const uint8_t BIN_COUNT = 4;
+
+// ==================== FAST PIN ACCESS ====================
+/**
+ * @brief Pin I/O resolved at compile time. On the ATmega328P (Uno/Nano) each call compiles to a
+ * single sbi/cbi/sbis instruction; other targets fall back to digitalWrite/digitalRead.
+ */
+template <uint8_t Pin>
+struct FastPin {
+#if defined(__AVR_ATmega328P__)
+    static_assert(Pin < 20, "FastPin: ATmega328P has digital pins 0-19 only");
+    static constexpr uint8_t MASK = 1 << (Pin < 8 ? Pin : (Pin < 14 ? Pin - 8 : Pin - 14));
+    static inline volatile uint8_t &port() { return Pin < 8 ? PORTD : (Pin < 14 ? PORTB : PORTC); }
+    static inline volatile uint8_t &in() { return Pin < 8 ? PIND : (Pin < 14 ? PINB : PINC); }
+
+    static inline void high() { port() |= MASK; }
+    static inline void low() { port() &= (uint8_t)~MASK; }
+    static inline bool read() { return (in() & MASK) != 0; }
+#else
+    static inline void high() { digitalWrite(Pin, HIGH); }
+    static inline void low() { digitalWrite(Pin, LOW); }
+    static inline bool read() { return digitalRead(Pin) == HIGH; }
+#endif
+};
+
+/**
+ * @brief NEMA23 step/dir/enable driver specialised on a machine profile. Enable is active LOW.
+ */
+template <class Profile>
+struct Nema23Driver {
+    typedef FastPin<Profile::NEMA23_STEP_PIN> StepPin;
+    typedef FastPin<Profile::NEMA23_DIR_PIN> DirPin;
+    typedef FastPin<Profile::NEMA23_ENABLE_PIN> EnablePin;
+
+    static void begin() {
+        pinMode(Profile::NEMA23_STEP_PIN, OUTPUT);
+        pinMode(Profile::NEMA23_DIR_PIN, OUTPUT);
+        pinMode(Profile::NEMA23_ENABLE_PIN, OUTPUT);
+        disable(); // disable by default
+    }
+    static inline void enable() { EnablePin::low(); }
+    static inline void disable() { EnablePin::high(); }
+    static inline void forward() { DirPin::high(); }
+    static inline void backward() { DirPin::low(); }
+    static inline void stepHigh() { StepPin::high(); }
+    static inline void stepLow() { StepPin::low(); }
+    static inline bool stepIsHigh() { return StepPin::read(); }
+
+    // Blocking move, used by calibration only
+    static void moveBlocking(int steps) {
+        for (int i = 0; i < steps; i++) {
+            stepHigh();
+            delayMicroseconds(Profile::STEP_PULSE_DELAY_US);
+            stepLow();
+            delayMicroseconds(Profile::STEP_PULSE_DELAY_US);
+        }
+    }
+};
+typedef Nema23Driver<Machine> Stepper;
 
 // ==================== EEPROM ADDRESSES ====================
 #define HX711_OFFSET_ADDR 0
@@ -44,13 +147,13 @@ bool systemActive = false;
 bool calibrationMode = false;
 bool stopRequested = false; // Graceful stop flag: finish current cycle before stopping
 bool plainMode = false;
+unsigned long eggId = 0; // Incremented for every load cycle; tags timestamped events
+bool eventTimestamps = false; // Enabled by TIME_SYNC: events end with " @<eggId>,<micros hex>" ("@-," if not tied to an egg)
 
-// Servo positions
-const int LOADER_HOME_POS = 160; // Loader MG996R Home position (Egg Holder Up/Safe)
-const int LOADER_LOAD_POS = 100;   // Loader MG996R Load position (Egg Holder Down/Release)
-const int MG996R_HOME_POS = 90; // MG996R Neutral/Home position (Only used on HOME/STOP)
 // MG996R Position Index: 0=BAD, 1=SMALL, 2=MEDIUM, 3=LARGE
-const int MG996R_POSITIONS[4] = {15, 70, 125, 170};
+const int MG996R_POSITIONS[BIN_COUNT] = {
+    Machine::BIN_POS_BAD, Machine::BIN_POS_SMALL, Machine::BIN_POS_MEDIUM, Machine::BIN_POS_LARGE
+};
 
 // Load cell calibration
 float hx711_scale = -1.96f;
@@ -65,13 +168,15 @@ float mediumMax = 50.0f;
 float largeMin = 51.0f;
 float largeMax = 58.0f;
 
+// Empty platter detection (g) - readings within +/- this band mean the loader delivered no egg
+float emptySlotThreshold = 10.0f;
+unsigned long misfeedCount = 0; // Number of EMPTY_SLOT cycles since boot
+
 // Stepper control
 int nema23_position = 0;
-const int NEMA23_STEPS = 1600; // Steps for one index movement
 
 // Stepper non-blocking control
 unsigned long lastStepTime = 0; // Tracks the last time the step pin was toggled (micros)
-const unsigned long STEP_PULSE_DELAY_US = 800; // Time for HIGH or LOW state of the pulse (800us HIGH + 800us LOW)
 int stepsRemainingInMove = 0; // Counter for the current move
 
 // Weight storage
@@ -80,6 +185,35 @@ float currentEggWeight = 0.0f;
 bool eggQualityIsGood = false;
 int weightClassificationIndex = 0; // Stores the size index (0-3)
 
+// Weighing mode
+// WEIGH_STRICT: a scale that is not ready gets a bounded retry window, then one re-weigh pass,
+//               then the egg is routed to the HOLD bin (BAD bin, index 0) and a fault is counted.
+// WEIGH_DEMO:   uncalibrated/not-ready readings are replaced with cycling test weights.
+enum WeighMode {
+    WEIGH_STRICT,
+    WEIGH_DEMO
+};
+WeighMode weighMode = ALLOW_UNCALIBRATED_START ? WEIGH_DEMO : WEIGH_STRICT;
+byte weighPass = 0; // Re-weigh passes used for the current egg
+bool weighHeld = false; // Current egg could not be weighed (WEIGH_HOLD); shares the BAD bin but is reported as HOLD
+unsigned long weighFaultCount = 0; // Number of WEIGH_FAULT events since boot
+const byte MAX_REWEIGH_PASSES = 1;
+const int HOLD_BIN_INDEX = 0; // No dedicated hold bin: held eggs go to the BAD bin
+
+// Adaptive weighing: running mean/variance (Welford) of single HX711 conversions.
+// Every egg gets WEIGH_FAST_SAMPLES; more are taken only while the estimate is too close to a grade boundary.
+byte weighSampleCount = 0;
+float weighMean = 0.0f;
+float weighM2 = 0.0f; // Sum of squared deviations from weighMean
+const byte WEIGH_FAST_SAMPLES = 3;
+const byte WEIGH_MAX_SAMPLES = 16;
+const float WEIGH_MIN_CLEARANCE_G = 0.2f; // Required boundary clearance floor (g)
+const float WEIGH_NOISE_FLOOR_G = 0.05f;  // Per-sample noise never assumed below this (g, 1 sigma; HX711 + load cell at 10 SPS)
+// Required boundary clearance in standard errors: Student-t quantiles equivalent to 3 sigma
+// (99.73%, two-sided) for 2..15 degrees of freedom, since sigma is estimated from few samples
+const float WEIGH_CLEARANCE_T[14] = {19.21f, 9.22f, 6.62f, 5.51f, 4.90f, 4.53f, 4.28f, 4.09f, 3.96f, 3.85f, 3.76f, 3.69f, 3.64f, 3.59f};
+static_assert(WEIGH_FAST_SAMPLES >= 3 && WEIGH_MAX_SAMPLES <= 17, "WEIGH_CLEARANCE_T covers 3..16 samples");
+
 // --- NON-BLOCKING STATE MACHINE ---
 // REMOVED MG996R_RETURN_INIT and MG996R_WAIT_HOME to prevent homing in every cycle
 enum SortingStep {
@@ -101,6 +235,7 @@ unsigned long stepStartTime = 0;
 const unsigned long TIME_SERVO_ACTUATE = 1500; // Time for SG90 to move fully
 const unsigned long TIME_SETTLE_VIBRATION = 500; // Wait after stepper stops
 const unsigned long TIME_SORT_ACTUATE = 2000;   // Time for egg to drop into bin
+const unsigned long TIME_WEIGH_READY_TIMEOUT = 300; // Max wait for HX711 ready per weigh pass (WEIGH_STRICT)
 // const unsigned long TIME_MG996R_RETURN = 500; // No longer needed as it doesn't return in cycle
 
 // ==================== SERIAL HANDLER VARIABLES ====================
@@ -112,9 +247,9 @@ void setup() {
     Serial.begin(115200);
     Serial.println(F("MEGG Hardware Control System Starting..."));
 
-    loader.attach(LOADER_SERVO_PIN);
-    mg996r.attach(MG996R_PIN);
-    hx711.begin(HX711_DT_PIN, HX711_SCK_PIN);
+    loader.attach(Machine::LOADER_SERVO_PIN);
+    mg996r.attach(Machine::MG996R_PIN);
+    hx711.begin(Machine::HX711_DT_PIN, Machine::HX711_SCK_PIN);
 
     EEPROM.get(HX711_OFFSET_ADDR, hx711_offset);
     EEPROM.get(HX711_SCALE_ADDR, hx711_scale);
@@ -129,17 +264,15 @@ void setup() {
     hx711_calibrated = (fabs(hx711_scale) > 0.0001f);
 
     // Stepper pins
-    pinMode(NEMA23_STEP_PIN, OUTPUT);
-    pinMode(NEMA23_DIR_PIN, OUTPUT);
-    pinMode(NEMA23_ENABLE_PIN, OUTPUT);
-    digitalWrite(NEMA23_ENABLE_PIN, HIGH); // disable by default
+    Stepper::begin();
 
-    loader.write(LOADER_HOME_POS);
-    mg996r.write(MG996R_HOME_POS);
+    loader.write(Machine::LOADER_HOME_POS);
+    mg996r.write(Machine::MG996R_HOME_POS);
     delay(1000);
 
     Serial.println(F("System Ready!"));
-    Serial.println(F("Commands: START [ranges], STOP, HOME, STATUS, SET_RANGES <s_min> <s_max> <m_min> <m_max> <l_min> <l_max>"));
+    Serial.println(F("Commands: START [ranges], STOP, HOME, STATUS, SET_RANGES <s_min> <s_max> <m_min> <m_max> <l_min> <l_max>, SET_EMPTY_THRESHOLD <g>, WEIGH_MODE <STRICT|DEMO>"));
+    Serial.println(F("Tracing: TIME_SYNC <seq>, TIME_SYNC OFF"));
     Serial.println(F("Calibration: CALIBRATE_UNO, CALIBRATE_HX711 [weight], CALIBRATE_NEMA23, CALIBRATE_LOADER, CALIBRATE_MG996R"));
 }
 
@@ -169,6 +302,9 @@ void handleSerialCommands() {
                 char *p = cmdBuf;
                 while (*p == ' ') p++;
 
+                // TIME_SYNC receive timestamp, taken before the CMD echo; other commands skip the micros() call
+                unsigned long lineReceivedUs = (strncmp(p, "TIME_SYNC", 9) == 0) ? micros() : 0;
+
                 Serial.print(F("CMD: "));
                 Serial.println(p);
 
@@ -188,13 +324,15 @@ void handleSerialCommands() {
                                               &m_min, &m_max,
                                               &l_min, &l_max) == 6) {
 
-                        smallMin = s_min;
-                        smallMax = s_max;
-                        mediumMin = m_min;
-                        mediumMax = m_max;
-                        largeMin = l_min;
-                        largeMax = l_max;
-                        Serial.println(F("CONFIG_UPDATED: Egg size ranges set successfully."));
+                        if (smallMinClearsEmptyThreshold(s_min)) {
+                            smallMin = s_min;
+                            smallMax = s_max;
+                            mediumMin = m_min;
+                            mediumMax = m_max;
+                            largeMin = l_min;
+                            largeMax = l_max;
+                            Serial.println(F("CONFIG_UPDATED: Egg size ranges set successfully."));
+                        }
 
                     } else if (strlen(p) > 5 && strncmp(p+5, " ", 1) != 0) {
                         Serial.println(F("ERROR: START with ranges requires 6 float arguments. Using current ranges."));
@@ -213,13 +351,15 @@ void handleSerialCommands() {
                                             &m_min, &m_max,
                                             &l_min, &l_max) == 6) {
 
-                        smallMin = s_min;
-                        smallMax = s_max;
-                        mediumMin = m_min;
-                        mediumMax = m_max;
-                        largeMin = l_min;
-                        largeMax = l_max;
-                        Serial.println(F("CONFIG_UPDATED: Egg size ranges set successfully."));
+                        if (smallMinClearsEmptyThreshold(s_min)) {
+                            smallMin = s_min;
+                            smallMax = s_max;
+                            mediumMin = m_min;
+                            mediumMax = m_max;
+                            largeMin = l_min;
+                            largeMax = l_max;
+                            Serial.println(F("CONFIG_UPDATED: Egg size ranges set successfully."));
+                        }
 
                     } else if (strlen(p) > 11 && strncmp(p+11, " ", 1) != 0) {
                         Serial.println(F("ERROR: START_PLAIN with ranges requires 6 float arguments. Using current ranges."));
@@ -254,11 +394,11 @@ void handleSerialCommands() {
 
                     if (strncmp(quality_arg, "GOOD", 4) == 0) {
                         eggQualityIsGood = true;
-                        Serial.println(F("QUALITY_RECEIVED: GOOD. Proceeding to sort."));
+                        printEvent(F("QUALITY_RECEIVED: GOOD. Proceeding to sort."));
                         currentSortingStep = STEP_SORT_ACTUATE;
                     } else if (strncmp(quality_arg, "BAD", 3) == 0) {
                         eggQualityIsGood = false;
-                        Serial.println(F("QUALITY_RECEIVED: BAD (Cracked). Routing to BAD bin."));
+                        printEvent(F("QUALITY_RECEIVED: BAD (Cracked). Routing to BAD bin."));
                         currentSortingStep = STEP_SORT_ACTUATE;
                     } else {
                         Serial.println(F("ERROR: QUALITY command requires GOOD or BAD argument."));
@@ -272,18 +412,76 @@ void handleSerialCommands() {
                                             &s_min, &s_max,
                                             &m_min, &m_max,
                                             &l_min, &l_max) == 6) {
-                        smallMin = s_min;
-                        smallMax = s_max;
-                        mediumMin = m_min;
-                        mediumMax = m_max;
-                        largeMin = l_min;
-                        largeMax = l_max;
-                        Serial.println(F("CONFIG_UPDATED: Egg size ranges set successfully."));
+                        if (smallMinClearsEmptyThreshold(s_min)) {
+                            smallMin = s_min;
+                            smallMax = s_max;
+                            mediumMin = m_min;
+                            mediumMax = m_max;
+                            largeMin = l_min;
+                            largeMax = l_max;
+                            Serial.println(F("CONFIG_UPDATED: Egg size ranges set successfully."));
+                        }
                     } else {
                         Serial.println(F("ERROR: SET_RANGES usage: SET_RANGES <s_min> <s_max> <m_min> <m_max> <l_min> <l_max>"));
                     }
                 }
 
+                // Command to set the empty platter threshold (misfeed detection)
+                else if (strncmp(p, "SET_EMPTY_THRESHOLD", 19) == 0) {
+                    float threshold;
+                    if (sscanf(p + 19, "%f", &threshold) != 1 || threshold < 0) {
+                        Serial.println(F("ERROR: SET_EMPTY_THRESHOLD usage: SET_EMPTY_THRESHOLD <grams>"));
+                    } else if (threshold >= smallMin) {
+                        // A threshold at or above smallMin would turn real small eggs into misfeeds
+                        Serial.print(F("ERROR: SET_EMPTY_THRESHOLD must be below SMALL min ("));
+                        Serial.print(smallMin, 1);
+                        Serial.println(F(" g)."));
+                    } else {
+                        emptySlotThreshold = threshold;
+                        Serial.print(F("CONFIG_UPDATED: Empty slot threshold set to "));
+                        Serial.print(emptySlotThreshold, 2);
+                        Serial.println(F(" g."));
+                    }
+                }
+
+                // Select production (STRICT) or demonstration (DEMO) weighing
+                else if (strncmp(p, "WEIGH_MODE", 10) == 0) {
+                    char *mode_arg = p + 10;
+                    while (*mode_arg == ' ') mode_arg++;
+
+                    if (strcmp(mode_arg, "STRICT") == 0 && systemActive && !hx711_calibrated) {
+                        // Only reachable after an uncalibrated DEMO start; STRICT would hold every egg
+                        Serial.println(F("SYSTEM_ERROR: Load cell not calibrated. STOP before selecting WEIGH_MODE STRICT."));
+                    } else if (strcmp(mode_arg, "STRICT") == 0) {
+                        weighMode = WEIGH_STRICT;
+                        Serial.println(F("CONFIG_UPDATED: Weigh mode STRICT."));
+                    } else if (strcmp(mode_arg, "DEMO") == 0) {
+                        weighMode = WEIGH_DEMO;
+                        Serial.println(F("CONFIG_UPDATED: Weigh mode DEMO (test weight injection enabled)."));
+                    } else {
+                        Serial.println(F("ERROR: WEIGH_MODE requires STRICT or DEMO argument."));
+                    }
+                }
+
+                // Clock sync probe from host: reply with device receive/transmit micros() (hex)
+                else if (strncmp(p, "TIME_SYNC", 9) == 0) {
+                    char *sync_arg = p + 9;
+                    while (*sync_arg == ' ') sync_arg++;
+
+                    if (strcmp(sync_arg, "OFF") == 0) {
+                        eventTimestamps = false;
+                        Serial.println(F("TIME_SYNC_OFF"));
+                    } else {
+                        eventTimestamps = true;
+                        Serial.print(F("TIME_SYNC_ACK "));
+                        Serial.print(strtoul(sync_arg, NULL, 10));
+                        Serial.print(' ');
+                        Serial.print(lineReceivedUs, HEX);
+                        Serial.print(' ');
+                        Serial.println(micros(), HEX);
+                    }
+                }
+
                 else if (strcmp(p, "CALIBRATE_UNO") == 0) calibrateUno();
                 else if (strcmp(p, "CALIBRATE_NEMA23") == 0) calibrateNema23();
                 else if (strcmp(p, "CALIBRATE_SG90") == 0) calibrateLoaderServo();
@@ -303,6 +501,42 @@ void handleSerialCommands() {
     }
 }
 
+// ==================== EVENT TIMESTAMPS ====================
+/**
+ * @brief Ends an event line. After TIME_SYNC, appends " @<eggId>,<micros hex>" so the host can
+ * map the event onto its own clock (micros() wraps every ~71 min; the host unwraps it).
+ * System events that belong to no egg (perEgg = false) carry "-" instead of an egg id.
+ */
+void endEvent(bool perEgg) {
+    if (eventTimestamps) {
+        Serial.print(F(" @"));
+        if (perEgg) Serial.print(eggId);
+        else Serial.print('-');
+        Serial.print(',');
+        Serial.print(micros(), HEX);
+    }
+    Serial.println();
+}
+
+void printEvent(const __FlashStringHelper *message, bool perEgg) {
+    Serial.print(message);
+    endEvent(perEgg);
+}
+
+// ==================== RANGE VALIDATION ====================
+/**
+ * @brief Range setters must keep SMALL min above the empty slot threshold; otherwise eggs
+ * lighter than the threshold would be dropped as EMPTY_SLOT misfeeds instead of sorted.
+ */
+bool smallMinClearsEmptyThreshold(float s_min) {
+    if (s_min > emptySlotThreshold) return true;
+
+    Serial.print(F("ERROR: SMALL min must be above the empty slot threshold ("));
+    Serial.print(emptySlotThreshold, 1);
+    Serial.println(F(" g). Using current ranges."));
+    return false;
+}
+
 // ==================== SYSTEM CONTROL ====================
 void startSystem() {
     if (systemActive) {
@@ -310,21 +544,21 @@ void startSystem() {
         return;
     }
 
-    // FIX 3: Check calibration and apply development bypass flag
+    // FIX 3: Check calibration; only WEIGH_DEMO may run without it
     if (!hx711_calibrated) {
-        if (!ALLOW_UNCALIBRATED_START) {
+        if (weighMode != WEIGH_DEMO) {
             Serial.println(F("SYSTEM_ERROR: Load cell not calibrated. Cannot start sorting."));
             return;
         } else {
-            Serial.println(F("SYSTEM_WARNING: Starting uncalibrated (ALLOW_UNCALIBRATED_START=true). Using test weight injection."));
+            Serial.println(F("SYSTEM_WARNING: Starting uncalibrated (WEIGH_MODE=DEMO). Using test weight injection."));
         }
     }
 
     systemActive = true;
-    digitalWrite(NEMA23_ENABLE_PIN, LOW); // Enable Stepper Motor
+    Stepper::enable(); // Enable Stepper Motor
     currentSortingStep = STEP_LOAD_EGG_DOWN; // Start the first step
     stepStartTime = millis();
-    Serial.println(F("SYSTEM_STARTED"));
+    printEvent(F("SYSTEM_STARTED"), false);
 }
 
 void stopSystem() {
@@ -339,7 +573,7 @@ void stopSystem() {
         return;
     }
     // Halt motor activity immediately
-    digitalWrite(NEMA23_ENABLE_PIN, HIGH); // Disable Stepper Motor
+    Stepper::disable(); // Disable Stepper Motor
 
     // Reset non-blocking stepper variables
     stepsRemainingInMove = 0;
@@ -349,14 +583,14 @@ void stopSystem() {
     systemActive = false;
     currentSortingStep = STEP_IDLE; // Reset sorting flow
 
-    Serial.println(F("SYSTEM_STOPPED"));
+    printEvent(F("SYSTEM_STOPPED"), false);
     Serial.println(F("STOP_ACK"));
 }
 
 // ==================== SERVO CONTROL ====================
 void homeServo() {
-    loader.write(LOADER_HOME_POS);
-    mg996r.write(MG996R_HOME_POS);
+    loader.write(Machine::LOADER_HOME_POS);
+    mg996r.write(Machine::MG996R_HOME_POS);
     Serial.println(F("SERVOS_HOMED"));
 }
 
@@ -416,7 +650,8 @@ int classifyEgg() {
     Serial.print(F("SORT: Egg ("));
     Serial.print(currentEggWeight, 2);
     Serial.print(F("g) classified as "));
-    Serial.println(sizeLabel);
+    Serial.print(sizeLabel);
+    endEvent();
 
     // Final check for the gap between Medium and Large (50.0 < W < 51.0 in default config)
     // The previous logic covers all cases correctly:
@@ -429,6 +664,51 @@ int classifyEgg() {
     return targetPositionIndex; // RETURN INDEX (0-3)
 }
 
+// ==================== ADAPTIVE WEIGHING ====================
+void resetWeighSamples() {
+    weighSampleCount = 0;
+    weighMean = 0.0f;
+    weighM2 = 0.0f;
+}
+
+void addWeighSample(float sample) {
+    weighSampleCount++;
+    float delta = sample - weighMean;
+    weighMean += delta / weighSampleCount;
+    weighM2 += delta * (sample - weighMean);
+}
+
+/**
+ * @brief Distance (g) from weight to the nearest threshold that changes the destination bin.
+ * smallMin and largeMax are skipped: crossing them only changes the label (UNDER_MIN / OVER_MAX).
+ */
+float nearestGradeBoundaryDistance(float weight) {
+    const float boundaries[5] = {emptySlotThreshold, smallMax, mediumMin, mediumMax, largeMin};
+    float nearest = fabs(weight - boundaries[0]);
+    for (byte i = 1; i < 5; i++) {
+        float distance = fabs(weight - boundaries[i]);
+        if (distance < nearest) nearest = distance;
+    }
+    return nearest;
+}
+
+/**
+ * @brief True once the running mean is far enough from every grade boundary, given the measured
+ * noise (floored at WEIGH_NOISE_FLOOR_G) and a small-sample t-value, or the sample cap is reached.
+ * Eggs well inside a grade stop after WEIGH_FAST_SAMPLES.
+ */
+bool weighEstimateIsSettled() {
+    if (weighSampleCount < WEIGH_FAST_SAMPLES) return false;
+    if (weighSampleCount >= WEIGH_MAX_SAMPLES) return true;
+
+    float sigma = sqrt(weighM2 / (weighSampleCount - 1));
+    if (sigma < WEIGH_NOISE_FLOOR_G) sigma = WEIGH_NOISE_FLOOR_G; // A quiet run of samples is not a quiet scale
+    float clearance = WEIGH_CLEARANCE_T[weighSampleCount - 3] * sigma / sqrt(weighSampleCount);
+    if (clearance < WEIGH_MIN_CLEARANCE_G) clearance = WEIGH_MIN_CLEARANCE_G;
+
+    return nearestGradeBoundaryDistance(weighMean) >= clearance;
+}
+
 // ==================== SYSTEM FLOW (NON-BLOCKING) ====================
 /**
  * @brief Executes the full MEGG system flow using a non-blocking state machine.
@@ -441,8 +721,11 @@ void runContinuousSorting() {
 
         case STEP_LOAD_EGG_DOWN:
             // 1. SG90: Move down (release egg)
-            loader.write(LOADER_LOAD_POS);
-            Serial.println(F("STEP: Load egg down."));
+            loader.write(Machine::LOADER_LOAD_POS);
+            weighPass = 0;
+            weighHeld = false;
+            eggId++;
+            printEvent(F("STEP: Load egg down."));
             stepStartTime = currentTime;
             currentSortingStep = STEP_LOAD_EGG_UP;
             break;
@@ -450,8 +733,8 @@ void runContinuousSorting() {
         case STEP_LOAD_EGG_UP:
             // 2. Wait for move time, then move up (home)
             if (currentTime - stepStartTime >= TIME_SERVO_ACTUATE) {
-                loader.write(LOADER_HOME_POS);
-                Serial.println(F("STEP: Load egg up (home). EGG_LOADED."));
+                loader.write(Machine::LOADER_HOME_POS);
+                printEvent(F("STEP: Load egg up (home). EGG_LOADED."));
                 // Move directly to NEMA23 move initialization
                 currentSortingStep = STEP_MOVE_TO_SCALE_INIT;
             }
@@ -459,11 +742,11 @@ void runContinuousSorting() {
 
         case STEP_MOVE_TO_SCALE_INIT:
             // Initialize NEMA23 non-blocking move
-            Serial.println(F("STEP: NEMA23 starting non-blocking forward move..."));
-            digitalWrite(NEMA23_DIR_PIN, HIGH); // Set direction FORWARD
-            digitalWrite(NEMA23_ENABLE_PIN, LOW); // Enable motor
+            printEvent(F("STEP: NEMA23 starting non-blocking forward move..."));
+            Stepper::forward(); // Set direction FORWARD
+            Stepper::enable(); // Enable motor
 
-            stepsRemainingInMove = NEMA23_STEPS;
+            stepsRemainingInMove = Machine::NEMA23_STEPS;
             lastStepTime = currentMicroseconds;
             currentSortingStep = STEP_STEPPER_MOVING;
             // No break: Fall through to start moving immediately in the same loop cycle
@@ -472,15 +755,15 @@ void runContinuousSorting() {
             // Execute non-blocking steps using micros() timing
             if (stepsRemainingInMove > 0) {
                 // Check if it's time for the next pulse state (HIGH or LOW)
-                if (currentMicroseconds - lastStepTime >= STEP_PULSE_DELAY_US) {
+                if (currentMicroseconds - lastStepTime >= Machine::STEP_PULSE_DELAY_US) {
 
-                    if (digitalRead(NEMA23_STEP_PIN) == LOW) {
+                    if (!Stepper::stepIsHigh()) {
                         // Start HIGH pulse
-                        digitalWrite(NEMA23_STEP_PIN, HIGH);
+                        Stepper::stepHigh();
                         lastStepTime = currentMicroseconds;
                     } else {
                         // End LOW pulse (a full step is complete)
-                        digitalWrite(NEMA23_STEP_PIN, LOW);
+                        Stepper::stepLow();
                         lastStepTime = currentMicroseconds;
                         stepsRemainingInMove--;
                     }
@@ -490,8 +773,8 @@ void runContinuousSorting() {
                 return;
             } else {
                 // Move finished
-                digitalWrite(NEMA23_ENABLE_PIN, HIGH); // Disable motor
-                Serial.println(F("STEP: NEMA23 finished forward move (Non-Blocking)."));
+                Stepper::disable(); // Disable motor
+                printEvent(F("STEP: NEMA23 finished forward move (Non-Blocking)."));
                 stepStartTime = currentTime; // Start timing for settling
                 currentSortingStep = STEP_WEIGH_WAIT;
             }
@@ -501,18 +784,61 @@ void runContinuousSorting() {
         case STEP_WEIGH_WAIT:
             // 4. Wait for vibration/settling after NEMA23 stops
             if (currentTime - stepStartTime >= TIME_SETTLE_VIBRATION) {
+                stepStartTime = currentTime; // Start of the HX711 ready window
+                resetWeighSamples();
                 currentSortingStep = STEP_WEIGH_READ;
             }
             break;
 
         case STEP_WEIGH_READ:
-            if (hx711.is_ready() && hx711_calibrated) {
-                currentEggWeight = hx711.get_units(10);
+            if (hx711_calibrated && hx711.is_ready()) {
+                // One conversion per loop() pass; keep sampling only while the grade is ambiguous
+                addWeighSample(hx711.get_units(1));
+                stepStartTime = currentTime; // Restart the HX711 ready window
+                if (!weighEstimateIsSettled()) {
+                    break;
+                }
+
+                currentEggWeight = weighMean;
                 Serial.print(F("HX711: Weight measured: "));
                 Serial.print(currentEggWeight, 2);
-                Serial.println(F(" g"));
+                Serial.print(F(" g ("));
+                Serial.print(weighSampleCount);
+                printEvent(F(" samples)"));
+            } else if (hx711_calibrated && currentTime - stepStartTime < TIME_WEIGH_READY_TIMEOUT) {
+                // Between conversions (or scale not ready): poll again on the next loop() pass
+                break;
+            } else if (weighMode == WEIGH_STRICT) {
+                weighFaultCount++;
+                if (!hx711_calibrated) {
+                    Serial.print(F("WEIGH_FAULT: HX711 not calibrated. Faults: "));
+                } else {
+                    Serial.print(F("WEIGH_FAULT: HX711 not ready after "));
+                    Serial.print(TIME_WEIGH_READY_TIMEOUT);
+                    Serial.print(F(" ms. Faults: "));
+                }
+                Serial.print(weighFaultCount);
+                endEvent();
+
+                // A re-weigh pass cannot help an uncalibrated scale
+                if (hx711_calibrated && weighPass < MAX_REWEIGH_PASSES) {
+                    // Re-settle and re-weigh the same egg
+                    weighPass++;
+                    printEvent(F("WEIGH_RETRY: Re-weighing egg."));
+                    resetWeighSamples();
+                    stepStartTime = currentTime;
+                    currentSortingStep = STEP_WEIGH_WAIT;
+                } else {
+                    // Never guess a grade: hold the egg and skip the quality check
+                    weightClassificationIndex = HOLD_BIN_INDEX;
+                    eggQualityIsGood = false;
+                    weighHeld = true;
+                    printEvent(F("WEIGH_HOLD: Scale unavailable. Routing egg to HOLD (BAD) bin."));
+                    currentSortingStep = STEP_SORT_ACTUATE;
+                }
+                break;
             } else {
-                // Test Weight Injection (Used if uncalibrated or HX711 not ready)
+                // Test Weight Injection (WEIGH_DEMO only: used if uncalibrated or HX711 not ready)
                 static float testWeight = 47.0f; 
                 testWeight += 25.0f; // Cycle through test weights (will be > largeMax quickly)
                 if (testWeight > 350.0f) testWeight = 47.0f; // Reset to a medium test weight
@@ -520,7 +846,26 @@ void runContinuousSorting() {
                 currentEggWeight = testWeight;
                 Serial.print(F("HX711: Test Weight ("));
                 Serial.print(currentEggWeight, 2);
-                Serial.println(F(" g, WARNING: Uncalibrated/Failed)"));
+                printEvent(F(" g, WARNING: Uncalibrated/Failed)"));
+            }
+
+            // Misfeed: the platter is (near) empty. Skip classification, vision and the drop cycle.
+            if (fabs(currentEggWeight) < emptySlotThreshold) {
+                misfeedCount++;
+                Serial.print(F("EMPTY_SLOT: No egg on platter ("));
+                Serial.print(currentEggWeight, 2);
+                Serial.print(F(" g). Misfeeds: "));
+                Serial.print(misfeedCount);
+                endEvent();
+
+                if (stopRequested) {
+                    stopRequested = false;
+                    stopSystem();
+                } else {
+                    currentSortingStep = STEP_LOAD_EGG_DOWN;
+                    printEvent(F("SYSTEM_FLOW_RESTART"));
+                }
+                break;
             }
 
             weightClassificationIndex = classifyEgg();
@@ -529,7 +874,7 @@ void runContinuousSorting() {
                 currentSortingStep = STEP_SORT_ACTUATE;
             } else {
                 eggQualityIsGood = false;
-                Serial.println(F("SORT_READY: Wait for quality check from frontend."));
+                printEvent(F("SORT_READY: Wait for quality check from frontend."));
                 stepStartTime = currentTime;
                 currentSortingStep = STEP_WAIT_FOR_QUALITY;
             }
@@ -543,7 +888,7 @@ void runContinuousSorting() {
                 const unsigned long QUALITY_WAIT_TIMEOUT_ON_STOP = 3000; // ms
                 if (currentTime - stepStartTime >= QUALITY_WAIT_TIMEOUT_ON_STOP) {
                     eggQualityIsGood = false; // Route to BAD bin by default if no UI input
-                    Serial.println(F("STOP_REQUESTED: No QUALITY within timeout. Auto-routing to BAD and finishing cycle."));
+                    printEvent(F("STOP_REQUESTED: No QUALITY within timeout. Auto-routing to BAD and finishing cycle."));
                     currentSortingStep = STEP_SORT_ACTUATE;
                 }
             }
@@ -555,8 +900,13 @@ void runContinuousSorting() {
             int finalBinIndex = weightClassificationIndex; // Start with the size determined by weight
             const char* finalBinLabel = "ERROR";
 
+            // Unweighed eggs share the BAD bin but must stay distinguishable from cracked ones
+            if (weighHeld) {
+                finalBinIndex = HOLD_BIN_INDEX;
+                finalBinLabel = "HOLD (UNWEIGHED)";
+            }
             // If quality is bad (e.g., cracked), override the bin to BAD (index 0)
-            if (!eggQualityIsGood || finalBinIndex == 0) {
+            else if (!eggQualityIsGood || finalBinIndex == 0) {
                 finalBinIndex = 0; // BAD bin index
                 finalBinLabel = "BAD (CRACKED/GAP)";
             } else {
@@ -573,7 +923,7 @@ void runContinuousSorting() {
             Serial.print(finalBinLabel);
             Serial.print(F(" bin at "));
             Serial.print(targetPos);
-            Serial.println(F(" degrees."));
+            printEvent(F(" degrees."));
 
             stepStartTime = currentTime;
             currentSortingStep = STEP_EGG_DROP_WAIT;
@@ -583,7 +933,7 @@ void runContinuousSorting() {
         case STEP_EGG_DROP_WAIT:
             // 5b. Wait for the egg to drop (Non-blocking delay)
             if (currentTime - stepStartTime >= TIME_SORT_ACTUATE) {
-                Serial.println(F("SYSTEM_FLOW_END: Egg dropped. MG996R remains in position."));
+                printEvent(F("SYSTEM_FLOW_END: Egg dropped. MG996R remains in position."));
 
                 // If a graceful stop was requested, perform stop now (at cycle boundary)
                 if (stopRequested) {
@@ -592,7 +942,7 @@ void runContinuousSorting() {
                 } else {
                     // Otherwise, restart immediately at step 1 for continuous operation
                     currentSortingStep = STEP_LOAD_EGG_DOWN;
-                    Serial.println(F("SYSTEM_FLOW_RESTART"));
+                    printEvent(F("SYSTEM_FLOW_RESTART"));
                 }
             }
             break;
@@ -657,29 +1007,19 @@ void calibrateNema23() {
     Serial.println(F("CALIBRATION_START:NEMA23"));
     calibrationMode = true;
 
-    digitalWrite(NEMA23_ENABLE_PIN, LOW);
+    Stepper::enable();
 
-    Serial.println(F("Moving forward 1600 steps (blocking)..."));
-    digitalWrite(NEMA23_DIR_PIN, HIGH);
-    for (int i = 0; i < 1600; i++) {
-        digitalWrite(NEMA23_STEP_PIN, HIGH);
-        delayMicroseconds(800);
-        digitalWrite(NEMA23_STEP_PIN, LOW);
-        delayMicroseconds(800);
-    }
+    Serial.print(F("Moving forward ")); Serial.print(Machine::NEMA23_STEPS); Serial.println(F(" steps (blocking)..."));
+    Stepper::forward();
+    Stepper::moveBlocking(Machine::NEMA23_STEPS);
 
     delay(500);
 
-    Serial.println(F("Moving backward 1600 steps (blocking)..."));
-    digitalWrite(NEMA23_DIR_PIN, LOW);
-    for (int i = 0; i < 1600; i++) {
-        digitalWrite(NEMA23_STEP_PIN, HIGH);
-        delayMicroseconds(800);
-        digitalWrite(NEMA23_STEP_PIN, LOW);
-        delayMicroseconds(800);
-    }
+    Serial.print(F("Moving backward ")); Serial.print(Machine::NEMA23_STEPS); Serial.println(F(" steps (blocking)..."));
+    Stepper::backward();
+    Stepper::moveBlocking(Machine::NEMA23_STEPS);
 
-    digitalWrite(NEMA23_ENABLE_PIN, HIGH);
+    Stepper::disable();
     calibrationMode = false;
     Serial.println(F("CALIBRATION_COMPLETE:NEMA23"));
 }
@@ -693,7 +1033,7 @@ void calibrateLoaderServo() {
 
     // 1. Move from current position down to 0 degrees (Min)
     Serial.println(F("LOADER: Sweeping to 0 degrees..."));
-    for (int pos = loader.read(); pos >= 100; pos -= 1) {
+    for (int pos = loader.read(); pos >= Machine::LOADER_LOAD_POS; pos -= 1) {
         loader.write(pos);
         delay(5);
     }
@@ -702,7 +1042,7 @@ void calibrateLoaderServo() {
 
     // 2. Move from 0 up to 100 degrees (Test Peak)
     Serial.println(F("LOADER: Sweeping to 100 degrees..."));
-    for (int pos = loader.read(); pos <= 160; pos += 1) {
+    for (int pos = loader.read(); pos <= Machine::LOADER_HOME_POS; pos += 1) {
         loader.write(pos);
         delay(5);
     }
@@ -711,7 +1051,7 @@ void calibrateLoaderServo() {
 
     // 3. Move from 100 back down to 0 degrees (Min)
     Serial.println(F("LOADER: Sweeping back to 0 degrees..."));
-    for (int pos = loader.read(); pos >= 100; pos -= 1) {
+    for (int pos = loader.read(); pos >= Machine::LOADER_LOAD_POS; pos -= 1) {
         loader.write(pos);
         delay(5);
     }
@@ -720,7 +1060,7 @@ void calibrateLoaderServo() {
 
     // 4. Return to home position (100 degrees)
     Serial.println(F("LOADER: Returning to 100 degrees (Home)."));
-    for (int pos = loader.read(); pos <= 160; pos += 1) {
+    for (int pos = loader.read(); pos <= Machine::LOADER_HOME_POS; pos += 1) {
         loader.write(pos);
         delay(5);
     }
@@ -732,8 +1072,8 @@ void calibrateLoaderServo() {
 void calibrateMG996R() {
     Serial.println(F("CALIBRATION_START:MG996R"));
     calibrationMode = true;
-    const char *labels[4] = {"BAD", "SMALL", "MEDIUM", "LARGE"};
-    for (int i = 0; i < 4; i++) {
+    const char *labels[BIN_COUNT] = {"BAD", "SMALL", "MEDIUM", "LARGE"};
+    for (int i = 0; i < BIN_COUNT; i++) {
         mg996r.write(MG996R_POSITIONS[i]);
         delay(1000);
         Serial.print(F("Position ")); Serial.print(labels[i]);
@@ -741,7 +1081,7 @@ void calibrateMG996R() {
         Serial.println(F("°"));
     }
     // MG996R returns to home (90 degrees) after calibration is complete
-    mg996r.write(MG996R_HOME_POS);
+    mg996r.write(Machine::MG996R_HOME_POS);
     delay(1000);
     calibrationMode = false;
     Serial.println(F("CALIBRATION_COMPLETE:MG996R"));
@@ -768,6 +1108,8 @@ void sendStatus() {
     Serial.print(F("LOADER: ")); Serial.print(loader.read()); Serial.println(F("°"));
     Serial.print(F("MG996R: ")); Serial.print(mg996r.read()); Serial.println(F("°"));
     Serial.print(F("HX711 Calibrated: ")); Serial.println(hx711_calibrated ? F("YES") : F("NO"));
+    Serial.print(F("Weigh Mode: ")); Serial.print(weighMode == WEIGH_STRICT ? F("STRICT") : F("DEMO"));
+    Serial.print(F(" (Faults: ")); Serial.print(weighFaultCount); Serial.println(F(")"));
 
     if (hx711_calibrated) {
         if (hx711.is_ready()) {
@@ -783,5 +1125,6 @@ void sendStatus() {
     Serial.print(F("SMALL: ")); Serial.print(smallMin, 1); Serial.print(F("g - ")); Serial.print(smallMax, 1); Serial.println(F("g"));
     Serial.print(F("MEDIUM: ")); Serial.print(mediumMin, 1); Serial.print(F("g - ")); Serial.print(mediumMax, 1); Serial.println(F("g"));
     Serial.print(F("LARGE: ")); Serial.print(largeMin, 1); Serial.print(F("g - ")); Serial.print(largeMax, 1); Serial.println(F("g"));
+    Serial.print(F("Empty Threshold: < ")); Serial.print(emptySlotThreshold, 1); Serial.print(F("g (Misfeeds: ")); Serial.print(misfeedCount); Serial.println(F(")"));
     Serial.println(F("==================="));
 }
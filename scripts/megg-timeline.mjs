@@ -0,0 +1,324 @@
+#!/usr/bin/env node
+/**
+ * MEGG end-to-end latency tracing.
+ *
+ *   node scripts/megg-timeline.mjs capture <port> <firmware.jsonl> [--baud 115200] [--sync-interval 10000]
+ *     Opens the sorter's serial port, keeps its clock synchronised with TIME_SYNC probes and writes
+ *     every firmware line as JSONL. Timestamped events get their device time mapped to host epoch ms.
+ *     Every record carries a "session" number that goes up on each firmware boot (egg ids restart at 0)
+ *     and continues from the highest session already in the output file.
+ *
+ *   node scripts/megg-timeline.mjs merge <firmware.jsonl> [vision.jsonl] [backend.jsonl] ...
+ *     Merges the timelines per (session, egg) and prints each step with the time since the previous one.
+ *
+ * Vision and backend logs are JSONL with one event per line:
+ *   { "session": 3, "egg": 12, "t": 1760000000123.4, "source": "vision", "event": "inference_done" }
+ * where "egg" is the id the firmware appends to SORT_READY (" @<egg>,<micros hex>"), "session" is the
+ * boot session it belongs to (see nextSession below) and "t" is epoch ms. Records without a session
+ * are skipped by merge.
+ *
+ * Only one process can own the serial port. A backend that already talks to the sorter can import
+ * TimeSync and parseFirmwareLine from this module instead of running "capture".
+ */
+import { createWriteStream, existsSync, readFileSync } from 'node:fs';
+import { performance } from 'node:perf_hooks';
+import { pathToFileURL } from 'node:url';
+
+const MICROS_RANGE = 2 ** 32;
+const BOOT_LINE = 'MEGG Hardware Control System Starting';
+const EVENT_SUFFIX = / @(\d+|-),([0-9A-Fa-f]+)$/;
+const LOAD_EVENT = 'STEP: Load egg down.';
+
+/** Host wall clock in epoch microseconds, monotonic within the process. */
+export function hostNowUs() {
+  return (performance.timeOrigin + performance.now()) * 1000;
+}
+
+/**
+ * Device-to-host clock model built from TIME_SYNC round trips.
+ *
+ * Each probe gives host send/receive times (t1, t4) and device receive/transmit times (t2, t3).
+ * Only the probes with the lowest round-trip delay are kept (queueing on the serial link only adds
+ * delay), and host time is fitted as a line over device time: the slope gives the drift and the
+ * intercept the offset.
+ */
+export class TimeSync {
+  constructor({ window = 32 } = {}) {
+    this.window = window;
+    this.reset();
+  }
+
+  /** Forget all samples, e.g. after the board rebooted and micros() restarted at zero. */
+  reset() {
+    this.samples = [];
+    this.lastRaw = null;
+    this.wraps = 0;
+    this.fit = null;
+  }
+
+  /** Extends a 32-bit micros() reading to a monotonic count. Readings must arrive in device order. */
+  unwrap(raw) {
+    if (this.lastRaw !== null && raw < this.lastRaw && this.lastRaw - raw > MICROS_RANGE / 2) {
+      this.wraps++;
+    }
+    this.lastRaw = raw;
+    return this.wraps * MICROS_RANGE + raw;
+  }
+
+  addSample(t1HostUs, t2Raw, t3Raw, t4HostUs) {
+    const t2 = this.unwrap(t2Raw);
+    const t3 = this.unwrap(t3Raw);
+    this.samples.push({
+      host: (t1HostUs + t4HostUs) / 2,
+      device: (t2 + t3) / 2,
+      rtt: (t4HostUs - t1HostUs) - (t3 - t2),
+    });
+    if (this.samples.length > this.window) this.samples.shift();
+    this.fit = this.computeFit();
+  }
+
+  computeFit() {
+    const minRtt = Math.min(...this.samples.map((s) => s.rtt));
+    const best = this.samples.filter((s) => s.rtt <= minRtt * 1.5 + 500);
+    const hostMean = best.reduce((sum, s) => sum + s.host, 0) / best.length;
+    const deviceMean = best.reduce((sum, s) => sum + s.device, 0) / best.length;
+
+    let slope = 1;
+    let sxx = 0;
+    let sxy = 0;
+    for (const s of best) {
+      sxx += (s.device - deviceMean) ** 2;
+      sxy += (s.device - deviceMean) * (s.host - hostMean);
+    }
+    // Need a few seconds of spread before the slope means anything
+    if (best.length >= 2 && sxx > 1e12) slope = sxy / sxx;
+
+    return { hostMean, deviceMean, slope, rttUs: minRtt };
+  }
+
+  get ready() {
+    return this.fit !== null;
+  }
+
+  /** Host us per device us, minus one, in ppm. Negative means the board's clock runs fast. */
+  get driftPpm() {
+    return this.fit ? (this.fit.slope - 1) * 1e6 : 0;
+  }
+
+  /** Host minus device clock (us), evaluated on the fitted line at the latest sample's device time. */
+  get offsetUs() {
+    if (!this.fit) return 0;
+    const { hostMean, deviceMean, slope } = this.fit;
+    const device = this.samples[this.samples.length - 1].device;
+    return hostMean + slope * (device - deviceMean) - device;
+  }
+
+  /** Maps a raw device micros() value to host epoch milliseconds. */
+  toHostMs(deviceRaw) {
+    const device = this.unwrap(deviceRaw);
+    const { hostMean, deviceMean, slope } = this.fit;
+    return (hostMean + slope * (device - deviceMean)) / 1000;
+  }
+}
+
+/**
+ * Splits a firmware line into message, egg id and raw device micros(). System events
+ * (SYSTEM_STARTED, SYSTEM_STOPPED) carry "@-" and get egg null.
+ * Returns null for lines without a timestamp (sent before TIME_SYNC, or not an event).
+ */
+export function parseFirmwareLine(line) {
+  const match = EVENT_SUFFIX.exec(line);
+  if (!match) return null;
+  const message = line.slice(0, match.index);
+  return {
+    message,
+    event: message.split(':')[0].trim(),
+    egg: match[1] === '-' ? null : Number(match[1]),
+    deviceRaw: parseInt(match[2], 16),
+  };
+}
+
+/**
+ * Boot session tracking. Call onLine() for every firmware line in order; it returns the session the
+ * line belongs to. The session goes up when the board reboots after it has sent timestamped events,
+ * so the reboot triggered by opening the port does not start a new session.
+ */
+export function nextSession(lastSession = 0) {
+  let session = lastSession + 1;
+  let sawEvents = false;
+  return {
+    onLine(line) {
+      if (line.startsWith(BOOT_LINE)) {
+        if (sawEvents) session++;
+        sawEvents = false;
+      } else if (EVENT_SUFFIX.test(line)) {
+        sawEvents = true;
+      }
+      return session;
+    },
+  };
+}
+
+// ==================== CAPTURE ====================
+function lastSessionIn(file) {
+  if (!existsSync(file)) return 0;
+  return readJsonl(file).reduce((max, record) => Math.max(max, record.session ?? 0), 0);
+}
+
+async function capture(path, outFile, { baud = 115200, syncInterval = 10000 } = {}) {
+  const { SerialPort, ReadlineParser } = await import('serialport');
+  const port = new SerialPort({ path, baudRate: baud });
+  const lines = port.pipe(new ReadlineParser({ delimiter: '\n' }));
+  const out = createWriteStream(outFile, { flags: 'a' });
+  const sync = new TimeSync();
+  const sessions = nextSession(lastSessionIn(outFile));
+  let currentSession = null;
+  const pending = new Map();
+  let seq = 0;
+
+  const probe = () => {
+    seq++;
+    pending.set(seq, hostNowUs());
+    port.write(`TIME_SYNC ${seq}\n`);
+  };
+  const burst = () => {
+    for (let i = 0; i < 8; i++) setTimeout(probe, i * 100);
+  };
+
+  lines.on('data', (raw) => {
+    const t4 = hostNowUs();
+    const line = raw.trim();
+    if (!line || line.startsWith('CMD: TIME_SYNC')) return;
+    const session = sessions.onLine(line);
+    if (session !== currentSession) {
+      currentSession = session;
+      console.log(`SESSION ${session}`);
+    }
+
+    if (line.startsWith('TIME_SYNC_ACK')) {
+      const [, ackSeq, t2, t3] = line.split(' ');
+      const t1 = pending.get(Number(ackSeq));
+      if (t1 === undefined) return;
+      pending.delete(Number(ackSeq));
+      sync.addSample(t1, parseInt(t2, 16), parseInt(t3, 16), t4);
+      return;
+    }
+
+    if (line.startsWith(BOOT_LINE)) {
+      // Opening the port resets an Uno; resync once setup() has finished
+      sync.reset();
+      pending.clear();
+      setTimeout(burst, 1500);
+    }
+
+    const record = { source: 'firmware', session, hostRx: t4 / 1000, message: line };
+    const parsed = parseFirmwareLine(line);
+    if (parsed && sync.ready) {
+      record.egg = parsed.egg;
+      record.event = parsed.event;
+      record.message = parsed.message;
+      record.t = sync.toHostMs(parsed.deviceRaw);
+      record.linkMs = record.hostRx - record.t; // Serial transmit + host read latency
+    }
+    out.write(`${JSON.stringify(record)}\n`);
+  });
+
+  port.on('open', () => {
+    console.log(`Capturing ${path} -> ${outFile}`);
+    setTimeout(burst, 2000);
+    setInterval(() => {
+      probe();
+      if (sync.ready) {
+        console.log(
+          `TIME_SYNC: offset ${(sync.offsetUs / 1000).toFixed(3)} ms, drift ${sync.driftPpm.toFixed(1)} ppm, ` +
+            `rtt ${(sync.fit.rttUs / 1000).toFixed(2)} ms`,
+        );
+      }
+    }, syncInterval);
+  });
+  port.on('error', (err) => {
+    console.error(`ERROR: ${err.message}`);
+    process.exit(1);
+  });
+}
+
+// ==================== MERGE ====================
+function readJsonl(file) {
+  return readFileSync(file, 'utf8')
+    .split('\n')
+    .filter((line) => line.trim())
+    .map((line) => JSON.parse(line));
+}
+
+function merge(files) {
+  const byEgg = new Map();
+  let skipped = 0;
+  for (const file of files) {
+    for (const record of readJsonl(file)) {
+      if (record.egg === undefined || record.egg === null || typeof record.t !== 'number') continue;
+      if (typeof record.session !== 'number') {
+        skipped++;
+        continue;
+      }
+      const key = `${record.session}:${record.egg}`;
+      if (!byEgg.has(key)) byEgg.set(key, { session: record.session, egg: record.egg, events: [] });
+      byEgg.get(key).events.push(record);
+    }
+  }
+  if (skipped > 0) console.error(`WARNING: Skipped ${skipped} egg records without a session`);
+
+  const timelines = [...byEgg.values()].sort((a, b) => a.session - b.session || a.egg - b.egg);
+  let early = 0;
+  for (const timeline of timelines) {
+    timeline.events.sort((a, b) => a.t - b.t);
+    // An egg's span starts at its own load step; anything earlier belongs to a previous cycle
+    const load = timeline.events.find((e) => e.source === 'firmware' && e.message === LOAD_EVENT);
+    if (load) {
+      const kept = timeline.events.filter((e) => e.t >= load.t);
+      early += timeline.events.length - kept.length;
+      timeline.events = kept;
+    }
+  }
+  if (early > 0) console.error(`WARNING: Dropped ${early} records timed before their egg's load step`);
+
+  for (const { session, egg, events } of timelines) {
+    const start = events[0].t;
+    console.log(`SESSION ${session} EGG ${egg} (${(events[events.length - 1].t - start).toFixed(1)} ms)`);
+    let previous = start;
+    for (const e of events) {
+      const label = e.message ?? e.event;
+      console.log(
+        `  ${(e.t - start).toFixed(1).padStart(9)} ms  +${(e.t - previous).toFixed(1).padStart(8)} ms  ` +
+          `${String(e.source).padEnd(9)} ${label}`,
+      );
+      previous = e.t;
+    }
+  }
+}
+
+// ==================== CLI ====================
+function main(argv) {
+  const [command, ...args] = argv;
+  const option = (name, fallback) => {
+    const i = args.indexOf(name);
+    return i >= 0 ? Number(args.splice(i, 2)[1]) : fallback;
+  };
+
+  if (command === 'capture' && args.length >= 2) {
+    const baud = option('--baud', 115200);
+    const syncInterval = option('--sync-interval', 10000);
+    return capture(args[0], args[1], { baud, syncInterval });
+  }
+  if (command === 'merge' && args.length >= 1) {
+    return merge(args);
+  }
+
+  console.error('Usage: megg-timeline.mjs capture <port> <firmware.jsonl> [--baud 115200] [--sync-interval 10000]');
+  console.error('       megg-timeline.mjs merge <firmware.jsonl> [vision.jsonl] [backend.jsonl] ...');
+  process.exit(2);
+}
+
+// Run the CLI only when executed directly, not when imported (argv[1] is absent under node -e / REPL)
+if (process.argv[1] && import.meta.url === pathToFileURL(process.argv[1]).href) {
+  main(process.argv.slice(2));
+}